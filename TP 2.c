@@ -1,8 +1,32 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 // =============== DATA STRUCTURE DEFINITIONS ===============
 
+// Payload size of a compressed block, chosen so that a block is 128 bytes
+#define CBLOCK_BYTES 104
+
+// Number of independent lists walked side by side by a batched search
+#define BATCH_WAYS 8
+
+// Hint the CPU to start loading a node before it is needed
+#if defined(__GNUC__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr) ((void)0)
+#endif
+
+// Update a reference count atomically so versions can be shared across threads
+// (without GCC builtins the update is plain and versions must stay in one thread)
+#if defined(__GNUC__)
+#define REF_INCREMENT(count) __atomic_add_fetch(&(count), 1, __ATOMIC_RELAXED)
+#define REF_DECREMENT(count) __atomic_sub_fetch(&(count), 1, __ATOMIC_ACQ_REL)
+#else
+#define REF_INCREMENT(count) (++(count))
+#define REF_DECREMENT(count) (--(count))
+#endif
+
 // Simple linked list node - contains data and pointer to next node
 typedef struct node {
     int data;
@@ -16,6 +40,54 @@ typedef struct dnode {
     struct dnode *next;
 } dnode;
 
+// Persistent list node - data and next never change once published, so nodes can
+// be shared between versions; only refCount is updated (through REF_INCREMENT /
+// REF_DECREMENT) and the node is reclaimed when the last reference is released
+typedef struct pnode {
+    int data;
+    int refCount;
+    struct pnode *next;
+} pnode;
+
+// Set operations available between two sorted lists
+typedef enum setOperation {
+    SET_UNION,
+    SET_INTERSECTION,
+    SET_DIFFERENCE
+} setOperation;
+
+// How a self-organizing search reorders the list after a hit
+typedef enum searchStrategy {
+    SEARCH_PLAIN,          // Leave the list as it is
+    SEARCH_MOVE_TO_FRONT,  // Move the found node to the head
+    SEARCH_TRANSPOSE       // Swap the found node with its predecessor
+} searchStrategy;
+
+// Running totals used to report the average probe length of searches
+typedef struct searchStats {
+    long searches;
+    long probes;
+} searchStats;
+
+// Compressed sorted list block - the header keeps the first and last values so
+// whole blocks can be skipped; the values after the first are stored as
+// varint-encoded deltas from their predecessor
+typedef struct cblock {
+    int first;
+    int last;
+    unsigned short count;  // Number of values in the block
+    unsigned short used;   // Number of payload bytes in use
+    struct cblock *next;
+    unsigned char bytes[CBLOCK_BYTES];
+} cblock;
+
+// Key of a batched search, sorted by value and remembering its original slot
+typedef struct batchKey {
+    int key;
+    int index;
+    int count;
+} batchKey;
+
 // =============== UTILITY FUNCTIONS ===============
 
 /**
@@ -93,6 +165,66 @@ int searchSimple(node *list, int x) {
     return 0;  // Value not found
 }
 
+/**
+ * Searches for a value in a simple linked list and reorders it on a hit
+ * so that frequently searched values migrate toward the head
+ * @param list - Address of the head pointer (updated when the head changes)
+ * @param x - Value to search for
+ * @param strategy - Plain, move-to-front or transpose
+ * @param stats - Totals to update with this search (may be NULL)
+ * @return 1 if found, 0 if not found
+ */
+int searchSelfOrganizing(node **list, int x, searchStrategy strategy, searchStats *stats) {
+    node *p = *list, *prev = NULL, *beforePrev = NULL;
+    long probes = 0;
+    int found = 0;
+    
+    while (p != NULL) {
+        probes++;
+        if (p->data == x) {
+            found = 1;
+            break;
+        }
+        beforePrev = prev;
+        prev = p;
+        p = p->next;
+    }
+    
+    if (stats != NULL) {
+        stats->searches++;
+        stats->probes += probes;
+    }
+    if (!found || prev == NULL)
+        return found;  // Not found, or already at the head
+    
+    if (strategy == SEARCH_MOVE_TO_FRONT) {
+        // Unlink the node and put it at the head
+        prev->next = p->next;
+        p->next = *list;
+        *list = p;
+    } else if (strategy == SEARCH_TRANSPOSE) {
+        // Swap the node with its predecessor
+        prev->next = p->next;
+        p->next = prev;
+        if (beforePrev != NULL)
+            beforePrev->next = p;
+        else
+            *list = p;
+    }
+    return found;
+}
+
+/**
+ * Computes the average number of nodes visited per search
+ * @param stats - Totals gathered by searchSelfOrganizing
+ * @return Average probe length, or 0 if no search was made
+ */
+double averageProbeLength(const searchStats *stats) {
+    if (stats->searches == 0)
+        return 0.0;
+    return (double)stats->probes / stats->searches;
+}
+
 /**
  * Deletes all occurrences of a value from a simple linked list
  * @param list - Pointer to the head of the list
@@ -606,12 +738,1063 @@ dnode *createCircularDoubly(int n) {
     return list;
 }
 
+// =============== PERSISTENT LINKED LIST FUNCTIONS ===============
+
+/**
+ * Allocates a persistent node holding one reference
+ * @param x - Value to store
+ * @param next - Node to link after it (the reference is taken over, not added)
+ * @return Pointer to the new node, or NULL if allocation failed
+ */
+pnode *newPersistentNode(int x, pnode *next) {
+    pnode *newNode = malloc(sizeof(*newNode));
+    if (newNode == NULL) {
+        printf("Memory allocation failed\n");
+        return NULL;
+    }
+    newNode->data = x;
+    newNode->refCount = 1;
+    newNode->next = next;
+    return newNode;
+}
+
+/**
+ * Adds a reference to a persistent list version
+ * The caller must already hold a reference to it (e.g. its own snapshot)
+ * @param list - Pointer to the head of the version
+ * @return The same head, now owned once more by the caller
+ */
+pnode *retainPersistent(pnode *list) {
+    if (list != NULL)
+        REF_INCREMENT(list->refCount);
+    return list;
+}
+
+/**
+ * Drops a reference to a persistent list version
+ * Nodes are freed only once nothing references them any more,
+ * so the shared tail of other versions stays intact
+ * @param list - Pointer to the head of the version
+ */
+void releasePersistent(pnode *list) {
+    pnode *temp;
+    // Stop at the first node still referenced elsewhere
+    while (list != NULL && REF_DECREMENT(list->refCount) == 0) {
+        temp = list;
+        list = list->next;
+        free(temp);
+    }
+}
+
+/**
+ * Takes a snapshot of a persistent list in O(1)
+ * The snapshot never changes, whatever is done to later versions
+ * @param list - Pointer to the head of the version
+ * @return Head of the snapshot (release it with releasePersistent)
+ */
+pnode *snapshotPersistent(pnode *list) {
+    return retainPersistent(list);
+}
+
+/**
+ * Prints a persistent list from head to NULL
+ * @param list - Pointer to the head of the version
+ */
+void printPersistentList(pnode *list) {
+    if (list == NULL) {
+        printf("\nList is empty\n");
+        return;
+    }
+    pnode *p = list;
+    printf("\nList: ");
+    while (p != NULL) {
+        printf("%d -> ", p->data);
+        p = p->next;
+    }
+    printf("NULL\n");
+}
+
+/**
+ * Builds a persistent list holding the same values as a simple linked list
+ * @param list - Pointer to the head of the simple list
+ * @return Head of the new version, or NULL if allocation failed
+ */
+pnode *persistentFromSimple(node *list) {
+    pnode *head = NULL, **link = &head;
+    
+    while (list != NULL) {
+        *link = newPersistentNode(list->data, NULL);
+        if (*link == NULL) {
+            releasePersistent(head);
+            return NULL;
+        }
+        link = &(*link)->next;
+        list = list->next;
+    }
+    return head;
+}
+
+/**
+ * Inserts a value into a sorted persistent list maintaining sort order
+ * Only the nodes before the insertion point are copied; the rest is shared
+ * @param list - Pointer to the head of the sorted version (left untouched)
+ * @param x - Value to insert
+ * @return Head of the new version (the old one remains valid)
+ */
+pnode *insertSortedPersistent(pnode *list, int x) {
+    pnode *head = NULL, **link = &head;
+    pnode *p = list;
+    
+    // Copy the path up to the insertion point
+    while (p != NULL && p->data < x) {
+        *link = newPersistentNode(p->data, NULL);
+        if (*link == NULL) {
+            releasePersistent(head);
+            return snapshotPersistent(list);
+        }
+        link = &(*link)->next;
+        p = p->next;
+    }
+    
+    // Link the new node in front of the shared tail
+    *link = newPersistentNode(x, retainPersistent(p));
+    if (*link == NULL) {
+        releasePersistent(p);
+        releasePersistent(head);
+        return snapshotPersistent(list);
+    }
+    return head;
+}
+
+/**
+ * Deletes all occurrences of a value from a persistent list
+ * Only the nodes up to the last occurrence are copied; the rest is shared
+ * @param list - Pointer to the head of the version (left untouched)
+ * @param x - Value to delete
+ * @return Head of the new version (the old one remains valid)
+ */
+pnode *deleteOccurrencePersistent(pnode *list, int x) {
+    pnode *head = NULL, **link = &head;
+    pnode *p, *last = NULL;
+    
+    // Find the last occurrence: everything after it can be shared
+    for (p = list; p != NULL; p = p->next) {
+        if (p->data == x)
+            last = p;
+    }
+    if (last == NULL)
+        return snapshotPersistent(list);  // Nothing to delete
+    
+    // Copy the path, skipping the occurrences
+    for (p = list; p != last; p = p->next) {
+        if (p->data == x)
+            continue;
+        *link = newPersistentNode(p->data, NULL);
+        if (*link == NULL) {
+            releasePersistent(head);
+            return snapshotPersistent(list);
+        }
+        link = &(*link)->next;
+    }
+    *link = retainPersistent(last->next);
+    return head;
+}
+
+// =============== SORTED LIST SET OPERATIONS ===============
+
+/**
+ * Tells whether a value belongs to the result of a set operation
+ * @param op - Set operation being computed
+ * @param inA - 1 if the value appears in the first list
+ * @param inB - 1 if the value appears in the second list
+ * @return 1 if the value must be kept, 0 otherwise
+ */
+int keepInSet(setOperation op, int inA, int inB) {
+    if (op == SET_UNION)
+        return inA || inB;
+    if (op == SET_INTERSECTION)
+        return inA && inB;
+    return inA && !inB;  // SET_DIFFERENCE
+}
+
+/**
+ * Skips every node holding a given value at the front of a sorted simple list
+ * @param list - Pointer to the head of the list
+ * @param x - Value of the run to skip
+ * @param reuse - 1 to take ownership of the skipped nodes, 0 to leave them alone
+ * @param kept - In reuse mode, set to the first node of the run if it is still
+ *               NULL; the other nodes of the run are freed. Unused otherwise
+ * @return Pointer to the first node after the run
+ */
+node *consumeRunSimple(node *list, int x, int reuse, node **kept) {
+    node *temp;
+    while (list != NULL && list->data == x) {
+        temp = list;
+        list = list->next;
+        if (reuse) {
+            // Keep one node to relink into the result, free the duplicates
+            if (*kept == NULL)
+                *kept = temp;
+            else
+                free(temp);
+        }
+    }
+    return list;
+}
+
+/**
+ * Merges two sorted simple lists into a sorted list without duplicates
+ * Both lists are walked once, so this runs in O(n + m)
+ * @param a - Pointer to the head of the first sorted list
+ * @param b - Pointer to the head of the second sorted list
+ * @param op - Union, intersection or difference (a minus b)
+ * @param reuse - 1 to relink the input nodes (both inputs are consumed),
+ *                0 to allocate a new list and leave the inputs untouched
+ * @return Pointer to the head of the result
+ */
+node *setOperationSimple(node *a, node *b, setOperation op, int reuse) {
+    node *result = NULL, **link = &result;
+    node *kept;
+    int x, inA, inB;
+    
+    while (a != NULL || b != NULL) {
+        // Smallest value at the front of either list
+        if (b == NULL || (a != NULL && a->data <= b->data))
+            x = a->data;
+        else
+            x = b->data;
+        inA = a != NULL && a->data == x;
+        inB = b != NULL && b->data == x;
+        
+        kept = NULL;
+        a = consumeRunSimple(a, x, reuse, &kept);
+        b = consumeRunSimple(b, x, reuse, &kept);
+        
+        if (!keepInSet(op, inA, inB)) {
+            free(kept);
+            continue;
+        }
+        if (!reuse) {
+            kept = malloc(sizeof(*kept));
+            if (kept == NULL) {
+                printf("Memory allocation failed\n");
+                *link = NULL;
+                freeSimpleList(result);
+                return NULL;
+            }
+            kept->data = x;
+        }
+        *link = kept;
+        link = &kept->next;
+    }
+    *link = NULL;
+    return result;
+}
+
+/**
+ * Removes duplicate values from a sorted simple list
+ * @param list - Pointer to the head of the sorted list
+ * @param reuse - 1 to keep the first node of each value and free the others,
+ *                0 to allocate a new list and leave the input untouched
+ * @return Pointer to the head of the list without duplicates
+ */
+node *dedupSimple(node *list, int reuse) {
+    return setOperationSimple(list, NULL, SET_UNION, reuse);
+}
+
+/**
+ * Skips every node holding a given value at the front of a sorted doubly list
+ * @param list - Pointer to the head of the list
+ * @param x - Value of the run to skip
+ * @param reuse - 1 to take ownership of the skipped nodes, 0 to leave them alone
+ * @param kept - In reuse mode, set to the first node of the run if it is still
+ *               NULL; the other nodes of the run are freed. Unused otherwise
+ * @return Pointer to the first node after the run
+ */
+dnode *consumeRunDoubly(dnode *list, int x, int reuse, dnode **kept) {
+    dnode *temp;
+    while (list != NULL && list->data == x) {
+        temp = list;
+        list = list->next;
+        if (reuse) {
+            // Keep one node to relink into the result, free the duplicates
+            if (*kept == NULL)
+                *kept = temp;
+            else
+                free(temp);
+        }
+    }
+    return list;
+}
+
+/**
+ * Merges two sorted doubly lists into a sorted list without duplicates
+ * Both lists are walked once, so this runs in O(n + m)
+ * @param a - Pointer to the head of the first sorted list
+ * @param b - Pointer to the head of the second sorted list
+ * @param op - Union, intersection or difference (a minus b)
+ * @param reuse - 1 to relink the input nodes (both inputs are consumed),
+ *                0 to allocate a new list and leave the inputs untouched
+ * @return Pointer to the head of the result
+ */
+dnode *setOperationDoubly(dnode *a, dnode *b, setOperation op, int reuse) {
+    dnode *result = NULL, *tail = NULL;
+    dnode *kept;
+    int x, inA, inB;
+    
+    while (a != NULL || b != NULL) {
+        // Smallest value at the front of either list
+        if (b == NULL || (a != NULL && a->data <= b->data))
+            x = a->data;
+        else
+            x = b->data;
+        inA = a != NULL && a->data == x;
+        inB = b != NULL && b->data == x;
+        
+        kept = NULL;
+        a = consumeRunDoubly(a, x, reuse, &kept);
+        b = consumeRunDoubly(b, x, reuse, &kept);
+        
+        if (!keepInSet(op, inA, inB)) {
+            free(kept);
+            continue;
+        }
+        if (!reuse) {
+            kept = malloc(sizeof(*kept));
+            if (kept == NULL) {
+                printf("Memory allocation failed\n");
+                freeDoublyList(result);
+                return NULL;
+            }
+            kept->data = x;
+        }
+        
+        // Append at the tail and update all pointers
+        kept->prev = tail;
+        kept->next = NULL;
+        if (tail != NULL)
+            tail->next = kept;
+        else
+            result = kept;
+        tail = kept;
+    }
+    return result;
+}
+
+/**
+ * Removes duplicate values from a sorted doubly list
+ * @param list - Pointer to the head of the sorted list
+ * @param reuse - 1 to keep the first node of each value and free the others,
+ *                0 to allocate a new list and leave the input untouched
+ * @return Pointer to the head of the list without duplicates
+ */
+dnode *dedupDoubly(dnode *list, int reuse) {
+    return setOperationDoubly(list, NULL, SET_UNION, reuse);
+}
+
+// =============== COMPRESSED SORTED LIST FUNCTIONS ===============
+
+/**
+ * Writes an unsigned value as a varint (7 bits per byte, high bit = more)
+ * @param buf - Destination buffer
+ * @param v - Value to write
+ * @return Number of bytes written
+ */
+int putVarint(unsigned char *buf, unsigned int v) {
+    int n = 0;
+    while (v >= 0x80) {
+        buf[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = (unsigned char)v;
+    return n;
+}
+
+/**
+ * Reads a varint written by putVarint
+ * @param buf - Source buffer
+ * @param pos - Read position, advanced past the varint
+ * @return The decoded value
+ */
+unsigned int getVarint(const unsigned char *buf, int *pos) {
+    unsigned int v = 0;
+    int shift = 0;
+    unsigned char byte;
+    do {
+        byte = buf[(*pos)++];
+        v |= (unsigned int)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return v;
+}
+
+/**
+ * Allocates an empty compressed block
+ * @return Pointer to the new block, or NULL if allocation failed
+ */
+cblock *newCompressedBlock() {
+    cblock *block = malloc(sizeof(*block));
+    if (block == NULL) {
+        printf("Memory allocation failed\n");
+        return NULL;
+    }
+    block->count = 0;
+    block->used = 0;
+    block->next = NULL;
+    return block;
+}
+
+/**
+ * Appends a value at the end of a block
+ * @param block - Block to append to
+ * @param x - Value to append (must not be smaller than the block's last value)
+ * @param limit - Maximum number of payload bytes the block may use
+ * @return 1 if the value was appended, 0 if it does not fit
+ */
+int appendToBlock(cblock *block, int x, int limit) {
+    unsigned char buf[5];
+    int n, i;
+    
+    if (block->count == 0) {
+        block->first = x;
+        block->last = x;
+        block->count = 1;
+        return 1;
+    }
+    // Unsigned difference stays exact even across the whole int range
+    n = putVarint(buf, (unsigned int)x - (unsigned int)block->last);
+    if (block->used + n > limit)
+        return 0;
+    
+    for (i = 0; i < n; i++)
+        block->bytes[block->used + i] = buf[i];
+    block->used += n;
+    block->last = x;
+    block->count++;
+    return 1;
+}
+
+/**
+ * Decodes all the values of a block
+ * @param block - Block to decode
+ * @param values - Destination (room for at least CBLOCK_BYTES + 1 values)
+ * @return Number of values decoded
+ */
+int decodeBlock(const cblock *block, int *values) {
+    int pos = 0, i;
+    unsigned int v = (unsigned int)block->first;
+    
+    if (block->count == 0)
+        return 0;
+    values[0] = block->first;
+    for (i = 1; i < block->count; i++) {
+        v += getVarint(block->bytes, &pos);
+        values[i] = (int)v;
+    }
+    return block->count;
+}
+
+/**
+ * Re-encodes a block from sorted values
+ * @param block - Block to overwrite
+ * @param values - Sorted values to encode
+ * @param count - Number of values
+ * @param limit - Maximum number of payload bytes the block may use
+ * @return Number of values that fit in the block
+ */
+int encodeBlock(cblock *block, const int *values, int count, int limit) {
+    int i;
+    block->count = 0;
+    block->used = 0;
+    for (i = 0; i < count; i++) {
+        if (!appendToBlock(block, values[i], limit))
+            break;
+    }
+    return i;
+}
+
+/**
+ * Prints a compressed sorted list from head to NULL
+ * @param list - Pointer to the first block
+ */
+void printCompressedList(cblock *list) {
+    int values[CBLOCK_BYTES + 1];
+    int i, count;
+    cblock *b;
+    
+    if (list == NULL) {
+        printf("\nList is empty\n");
+        return;
+    }
+    printf("\nCompressed List: ");
+    for (b = list; b != NULL; b = b->next) {
+        count = decodeBlock(b, values);
+        for (i = 0; i < count; i++)
+            printf("%d -> ", values[i]);
+    }
+    printf("NULL\n");
+}
+
+/**
+ * Frees all blocks of a compressed sorted list
+ * @param list - Pointer to the first block
+ */
+void freeCompressedList(cblock *list) {
+    cblock *temp;
+    while (list != NULL) {
+        temp = list;
+        list = list->next;
+        free(temp);
+    }
+}
+
+/**
+ * Computes the memory held by a compressed sorted list
+ * @param list - Pointer to the first block
+ * @return Number of bytes allocated for its blocks
+ */
+size_t compressedMemoryUsage(cblock *list) {
+    size_t bytes = 0;
+    for (; list != NULL; list = list->next)
+        bytes += sizeof(*list);
+    return bytes;
+}
+
+/**
+ * Builds a compressed list holding the values of a sorted simple list
+ * @param list - Pointer to the head of the sorted simple list
+ * @return Pointer to the first block, or NULL if allocation failed
+ */
+cblock *compressedFromSimple(node *list) {
+    cblock *head = NULL, *tail = NULL, *block;
+    
+    for (; list != NULL; list = list->next) {
+        if (tail != NULL && appendToBlock(tail, list->data, CBLOCK_BYTES))
+            continue;
+        // Current block is full: start a new one
+        block = newCompressedBlock();
+        if (block == NULL) {
+            freeCompressedList(head);
+            return NULL;
+        }
+        appendToBlock(block, list->data, CBLOCK_BYTES);
+        if (tail != NULL)
+            tail->next = block;
+        else
+            head = block;
+        tail = block;
+    }
+    return head;
+}
+
+/**
+ * Searches for a value in a compressed sorted list
+ * Blocks whose range cannot hold the value are skipped from their header
+ * @param list - Pointer to the first block
+ * @param x - Value to search for
+ * @return 1 if found, 0 if not found
+ */
+int searchCompressed(cblock *list, int x) {
+    cblock *b = list;
+    int pos = 0, i;
+    unsigned int v;
+    
+    // Skip whole blocks that end before x
+    while (b != NULL && b->last < x)
+        b = b->next;
+    if (b == NULL || b->first > x)
+        return 0;
+    
+    // Decode only this block, stopping as soon as x is reached or passed
+    v = (unsigned int)b->first;
+    for (i = 1; (int)v < x && i < b->count; i++)
+        v += getVarint(b->bytes, &pos);
+    return (int)v == x;
+}
+
+/**
+ * Inserts a value in place inside a block if the block has room for it
+ * @param block - Block to insert into (left untouched if x does not fit)
+ * @param x - Value to insert
+ * @return 1 if the value was inserted, 0 if the block is full
+ */
+int insertIntoBlock(cblock *block, int x) {
+    int values[CBLOCK_BYTES + 2];
+    int count, i;
+    cblock trial;
+    
+    // Decode, insert in place and re-encode
+    count = decodeBlock(block, values);
+    for (i = count; i > 0 && values[i - 1] > x; i--)
+        values[i] = values[i - 1];
+    values[i] = x;
+    count++;
+    
+    // Check that the block can take the new value before touching it
+    if (encodeBlock(&trial, values, count, CBLOCK_BYTES) != count)
+        return 0;
+    encodeBlock(block, values, count, CBLOCK_BYTES);
+    return 1;
+}
+
+/**
+ * Inserts a value into a compressed sorted list maintaining sort order
+ * A full block hands the value to its neighbour when it has room,
+ * otherwise it is split at the insertion point
+ * @param list - Pointer to the first block
+ * @param x - Value to insert
+ * @return New first block (may change if the list was empty)
+ */
+cblock *insertSortedCompressed(cblock *list, int x) {
+    int values[CBLOCK_BYTES + 1];
+    int count, pos;
+    cblock *b, *spill;
+    
+    if (list == NULL) {
+        b = newCompressedBlock();
+        if (b == NULL)
+            return list;
+        appendToBlock(b, x, CBLOCK_BYTES);
+        return b;
+    }
+    
+    // Find the last block starting at or before x (the first one if none does)
+    b = list;
+    while (b->next != NULL && b->next->first <= x)
+        b = b->next;
+    
+    // Past the end of the block: append, else put x at the front of the next
+    // block (which starts after x), else start a new block between them
+    if (x >= b->last) {
+        if (appendToBlock(b, x, CBLOCK_BYTES))
+            return list;
+        if (b->next != NULL && insertIntoBlock(b->next, x))
+            return list;
+        spill = newCompressedBlock();
+        if (spill == NULL)
+            return list;
+        appendToBlock(spill, x, CBLOCK_BYTES);
+        spill->next = b->next;
+        b->next = spill;
+        return list;
+    }
+    
+    if (insertIntoBlock(b, x))
+        return list;
+    
+    // Split at the insertion point: the values after x move to a new block,
+    // x is appended to the ones before it (its delta is no longer than the
+    // one it replaces, so both parts fit)
+    spill = newCompressedBlock();
+    if (spill == NULL)
+        return list;
+    count = decodeBlock(b, values);
+    for (pos = 0; values[pos] <= x; pos++)
+        ;  // Stops before the end since x < b->last
+    encodeBlock(spill, values + pos, count - pos, CBLOCK_BYTES);
+    encodeBlock(b, values, pos, CBLOCK_BYTES);
+    appendToBlock(b, x, CBLOCK_BYTES);
+    spill->next = b->next;
+    b->next = spill;
+    return list;
+}
+
+/**
+ * Merges the block following a block into it when both fit in one block
+ * @param block - Block to merge into
+ * @return 1 if the blocks were merged, 0 otherwise
+ */
+int mergeWithNextBlock(cblock *block) {
+    int values[CBLOCK_BYTES + 1];
+    int count, i;
+    cblock *next = block->next, trial;
+    
+    // The delta joining the two blocks takes at least one more byte
+    if (next == NULL || block->used + 1 + next->used > CBLOCK_BYTES)
+        return 0;
+    
+    // Append the next block's values to a copy, keep it only if all fit
+    trial = *block;
+    count = decodeBlock(next, values);
+    for (i = 0; i < count; i++) {
+        if (!appendToBlock(&trial, values[i], CBLOCK_BYTES))
+            return 0;
+    }
+    *block = trial;
+    block->next = next->next;
+    free(next);
+    return 1;
+}
+
+/**
+ * Deletes all occurrences of a value from a compressed sorted list
+ * Blocks left small enough are merged with their neighbour
+ * @param list - Pointer to the first block
+ * @param x - Value to delete
+ * @return New first block (may change if the first block becomes empty)
+ */
+cblock *deleteOccurrenceCompressed(cblock *list, int x) {
+    int values[CBLOCK_BYTES + 1];
+    int count, kept, i;
+    cblock *b = list, *prev = NULL, *temp;
+    
+    // Only blocks whose range contains x need decoding
+    while (b != NULL && b->first <= x) {
+        if (b->last < x) {
+            prev = b;
+            b = b->next;
+            continue;
+        }
+        count = decodeBlock(b, values);
+        kept = 0;
+        for (i = 0; i < count; i++) {
+            if (values[i] != x)
+                values[kept++] = values[i];
+        }
+        
+        if (kept == 0) {
+            // Block is empty: unlink and free it
+            temp = b;
+            b = b->next;
+            if (prev != NULL)
+                prev->next = b;
+            else
+                list = b;
+            free(temp);
+            continue;
+        }
+        // Removing values never makes the encoding longer
+        encodeBlock(b, values, kept, CBLOCK_BYTES);
+        if (prev != NULL && mergeWithNextBlock(prev))
+            b = prev;  // b was folded into the previous block
+        prev = b;
+        b = b->next;
+    }
+    
+    // The first untouched block may now fit into the last one processed
+    if (prev != NULL)
+        mergeWithNextBlock(prev);
+    return list;
+}
+
+// =============== BATCHED SEARCH FUNCTIONS ===============
+
+/**
+ * Orders two batch keys by value (qsort comparator)
+ * @param a - Pointer to the first batchKey
+ * @param b - Pointer to the second batchKey
+ * @return Negative, zero or positive as a is below, equal to or above b
+ */
+int compareBatchKeys(const void *a, const void *b) {
+    const batchKey *ka = a, *kb = b;
+    return (ka->key > kb->key) - (ka->key < kb->key);
+}
+
+/**
+ * Builds the sorted key table used by the batched searches
+ * @param keys - Values to look up
+ * @param k - Number of keys
+ * @return Sorted table with zeroed counts, or NULL if allocation failed
+ */
+batchKey *prepareBatchKeys(const int *keys, int k) {
+    batchKey *table = malloc((k > 0 ? k : 1) * sizeof(*table));
+    int i;
+    
+    if (table == NULL) {
+        printf("Memory allocation failed\n");
+        return NULL;
+    }
+    for (i = 0; i < k; i++) {
+        table[i].key = keys[i];
+        table[i].index = i;
+        table[i].count = 0;
+    }
+    qsort(table, k, sizeof(*table), compareBatchKeys);
+    return table;
+}
+
+/**
+ * Counts one occurrence of a value if it is one of the keys
+ * Only the first entry of a run of equal keys is counted
+ * @param table - Sorted key table
+ * @param k - Number of keys
+ * @param x - Value read from the list
+ */
+void countBatchKey(batchKey *table, int k, int x) {
+    int low = 0, high = k;
+    
+    // Binary search for the first key >= x
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (table[mid].key < x)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low < k && table[low].key == x)
+        table[low].count++;
+}
+
+/**
+ * Copies the counts back in the order of the original keys and frees the table
+ * @param table - Sorted key table
+ * @param k - Number of keys
+ * @param counts - Receives the number of occurrences of each key
+ * @return Number of keys found at least once
+ */
+int finishBatchKeys(batchKey *table, int k, int *counts) {
+    int i, found = 0;
+    
+    for (i = 0; i < k; i++) {
+        // Repeated keys share the count of the first one
+        if (i > 0 && table[i].key == table[i - 1].key)
+            table[i].count = table[i - 1].count;
+        counts[table[i].index] = table[i].count;
+        if (table[i].count > 0)
+            found++;
+    }
+    free(table);
+    return found;
+}
+
+/**
+ * Searches for many values in a simple linked list in a single traversal
+ * @param list - Pointer to the head of the list
+ * @param keys - Values to search for
+ * @param k - Number of keys
+ * @param counts - Receives the number of occurrences of each key (0 = not found)
+ * @return Number of keys found, or -1 if allocation failed
+ */
+int searchBatchSimple(node *list, const int *keys, int k, int *counts) {
+    batchKey *table = prepareBatchKeys(keys, k);
+    node *p;
+    
+    if (table == NULL)
+        return -1;
+    for (p = list; p != NULL; p = p->next) {
+        PREFETCH(p->next);
+        countBatchKey(table, k, p->data);
+    }
+    return finishBatchKeys(table, k, counts);
+}
+
+/**
+ * Searches for many values in several independent simple linked lists
+ * Up to BATCH_WAYS lists are walked side by side so that their cache misses
+ * overlap instead of being paid one after another
+ * @param lists - Heads of the lists
+ * @param nlists - Number of lists
+ * @param keys - Values to search for
+ * @param k - Number of keys
+ * @param counts - Receives the number of occurrences of each key over all lists
+ * @return Number of keys found, or -1 if allocation failed
+ */
+int searchBatchMultiList(node **lists, int nlists, const int *keys, int k, int *counts) {
+    batchKey *table = prepareBatchKeys(keys, k);
+    node *cursor[BATCH_WAYS];
+    node *p;
+    int start, ways, active, i;
+    
+    if (table == NULL)
+        return -1;
+    for (start = 0; start < nlists; start += BATCH_WAYS) {
+        ways = nlists - start < BATCH_WAYS ? nlists - start : BATCH_WAYS;
+        for (i = 0; i < ways; i++)
+            cursor[i] = lists[start + i];
+        
+        // Advance every chain by one node per round
+        do {
+            active = 0;
+            for (i = 0; i < ways; i++) {
+                p = cursor[i];
+                if (p == NULL)
+                    continue;
+                cursor[i] = p->next;
+                PREFETCH(p->next);
+                countBatchKey(table, k, p->data);
+                active = 1;
+            }
+        } while (active);
+    }
+    return finishBatchKeys(table, k, counts);
+}
+
+/**
+ * Builds a simple linked list of random values whose nodes are linked in
+ * shuffled memory order, so a traversal chases pointers like a real list would
+ * @param n - Number of nodes
+ * @param range - Values are drawn from 0 to range - 1
+ * @return Pointer to the head of the list, or NULL if allocation failed
+ */
+node *createRandomSimpleList(int n, int range) {
+    node **nodes = malloc((n > 0 ? n : 1) * sizeof(*nodes));
+    node *list = NULL, *temp;
+    int i, j;
+    
+    if (nodes == NULL) {
+        printf("Memory allocation failed\n");
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        nodes[i] = malloc(sizeof(**nodes));
+        if (nodes[i] == NULL) {
+            printf("Memory allocation failed\n");
+            while (i > 0)
+                free(nodes[--i]);
+            free(nodes);
+            return NULL;
+        }
+        nodes[i]->data = rand() % range;
+    }
+    
+    // Fisher-Yates shuffle of the link order
+    for (i = n - 1; i > 0; i--) {
+        j = rand() % (i + 1);
+        temp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = temp;
+    }
+    for (i = n - 1; i >= 0; i--) {
+        nodes[i]->next = list;
+        list = nodes[i];
+    }
+    free(nodes);
+    return list;
+}
+
+/**
+ * Times repeated searchSimple calls against the batched searches
+ * and checks that every approach finds the same keys
+ * @param lists - Heads of the lists to search
+ * @param nlists - Number of lists
+ * @param keys - Values to look up
+ * @param k - Number of keys
+ * @param counts - Scratch array of k counts
+ * @param totals - Scratch array of k counts
+ */
+void timeBatchSearch(node **lists, int nlists, const int *keys, int k, int *counts, int *totals) {
+    int i, j, n, total, hit, found, foundBatched, differ;
+    clock_t start;
+    double repeated, perList, batched;
+    node *p;
+    
+    // Single list: one traversal per key against one traversal in total
+    start = clock();
+    found = 0;
+    for (i = 0; i < k; i++)
+        found += searchSimple(lists[0], keys[i]);
+    repeated = (double)(clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+    foundBatched = searchBatchSimple(lists[0], keys, k, counts);
+    batched = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (foundBatched < 0)
+        return;  // searchBatchSimple already reported the allocation failure
+    for (n = 0, p = lists[0]; p != NULL; p = p->next)
+        n++;
+    printf("\nOne list of %d nodes, %d keys (%d found):\n", n, k, found);
+    printf("  repeated searchSimple:      %.3f s\n", repeated);
+    printf("  searchBatchSimple:          %.3f s\n", batched);
+    if (foundBatched != found)
+        printf("  Results differ: %d keys found by the batched search!\n", foundBatched);
+    
+    // All lists: every key searched in every list
+    start = clock();
+    found = 0;
+    for (i = 0; i < k; i++) {
+        hit = 0;
+        for (j = 0; j < nlists; j++)
+            hit |= searchSimple(lists[j], keys[i]);
+        found += hit;
+    }
+    repeated = (double)(clock() - start) / CLOCKS_PER_SEC;
+    
+    // One batched pass per list, walking the lists one after another
+    start = clock();
+    for (i = 0; i < k; i++)
+        totals[i] = 0;
+    for (j = 0; j < nlists; j++) {
+        if (searchBatchSimple(lists[j], keys, k, counts) < 0)
+            return;
+        for (i = 0; i < k; i++)
+            totals[i] += counts[i];
+    }
+    perList = (double)(clock() - start) / CLOCKS_PER_SEC;
+    
+    // One batched pass walking the lists side by side
+    start = clock();
+    foundBatched = searchBatchMultiList(lists, nlists, keys, k, counts);
+    batched = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (foundBatched < 0)
+        return;
+    
+    for (total = 0, j = 0; j < nlists; j++) {
+        for (p = lists[j]; p != NULL; p = p->next)
+            total++;
+    }
+    printf("%d lists, %d nodes in total, %d keys (%d found):\n", nlists, total, k, found);
+    printf("  repeated searchSimple:      %.3f s\n", repeated);
+    printf("  searchBatchSimple per list: %.3f s\n", perList);
+    printf("  searchBatchMultiList:       %.3f s\n", batched);
+    differ = foundBatched != found;
+    for (i = 0; i < k; i++) {
+        if (totals[i] != counts[i])
+            differ = 1;
+    }
+    if (differ)
+        printf("  Results differ between the batched searches!\n");
+}
+
+/**
+ * Builds random lists and keys, then benchmarks the searches on them
+ * @param n - Total number of nodes, spread over the lists
+ * @param k - Number of keys to look up
+ * @param nlists - Number of independent lists
+ */
+void benchmarkBatchSearch(int n, int k, int nlists) {
+    node **lists = malloc(nlists * sizeof(*lists));
+    int *keys = malloc(k * sizeof(*keys));
+    int *counts = malloc(k * sizeof(*counts));
+    int *totals = malloc(k * sizeof(*totals));
+    int i, built = 0;
+    
+    if (lists == NULL || keys == NULL || counts == NULL || totals == NULL) {
+        printf("Memory allocation failed\n");
+    } else {
+        // Spread the nodes evenly, the first n % nlists lists taking one more
+        while (built < nlists) {
+            lists[built] = createRandomSimpleList(n / nlists + (built < n % nlists), 2 * n);
+            if (lists[built] == NULL)
+                break;  // createRandomSimpleList already reported the failure
+            built++;
+        }
+        if (built == nlists) {
+            for (i = 0; i < k; i++)
+                keys[i] = rand() % (2 * n);
+            timeBatchSearch(lists, nlists, keys, k, counts, totals);
+        }
+    }
+    
+    // Only the lists built so far are freed
+    for (i = 0; i < built; i++)
+        freeSimpleList(lists[i]);
+    free(lists);
+    free(keys);
+    free(counts);
+    free(totals);
+}
+
 // =============== MAIN FUNCTION ===============
 
 int main() {
     int listType, operation, n, value;
-    node *simpleList = NULL;
-    dnode *doublyList = NULL;
+    node *simpleList = NULL, *otherSimple = NULL, *p;
+    pnode *version = NULL, *snapshot = NULL;
+    dnode *doublyList = NULL, *otherDoubly = NULL;
+    setOperation op;
+    searchStats stats = {0, 0};
+    cblock *compressed = NULL;
+    int *keys, *counts;
+    int strategy, i, nkeys, nlists;
     node *circularSimple = NULL;
     dnode *circularDoubly = NULL;
     
@@ -670,8 +1853,15 @@ int main() {
     if (listType == 1) {
         printf("1. Read an element and delete all its occurrences\n");
         printf("2. Insert an element in sorted order\n");
+        printf("3. Insert and delete on a new version, keeping a snapshot\n");
+        printf("4. Combine with a second list (union, intersection, difference)\n");
+        printf("5. Remove duplicate values\n");
+        printf("6. Run a series of self-organizing searches\n");
+        printf("7. Store the sorted list in compressed blocks\n");
+        printf("8. Search for several values in a single traversal\n");
+        printf("9. Benchmark batched search against repeated searches\n");
         
-        operation = getIntInput("Enter your choice (1-2): ");
+        operation = getIntInput("Enter your choice (1-9): ");
         
         if (operation == 1) {
             // Search and delete operation
@@ -694,6 +1884,159 @@ int main() {
             simpleList = insertSortedSimple(simpleList, value);
             printf("After insertion: ");
             printSimpleList(simpleList);
+        } else if (operation == 3) {
+            // Persistent versions sharing their untouched tail
+            printf("\nSorting the list first...\n");
+            simpleList = sortSimpleList(simpleList);
+            version = persistentFromSimple(simpleList);
+            if (version == NULL) {
+                freeSimpleList(simpleList);
+                return 1;
+            }
+            snapshot = snapshotPersistent(version);
+            printPersistentList(version);
+            
+            value = getIntInput("\nEnter a value to insert in sorted order: ");
+            pnode *next = insertSortedPersistent(version, value);
+            releasePersistent(version);
+            version = next;
+            value = getIntInput("Enter a value to delete: ");
+            next = deleteOccurrencePersistent(version, value);
+            releasePersistent(version);
+            version = next;
+            
+            printf("New version: ");
+            printPersistentList(version);
+            printf("Snapshot (unchanged): ");
+            printPersistentList(snapshot);
+            releasePersistent(version);
+            releasePersistent(snapshot);
+        } else if (operation == 4) {
+            // Merge-based set operation between two sorted lists
+            n = getIntInput("\nEnter the number of elements in the second list: ");
+            if (n <= 0) {
+                printf("Invalid number of elements!\n");
+                freeSimpleList(simpleList);
+                return 1;
+            }
+            otherSimple = createSimpleList(n);
+            if (otherSimple == NULL) {
+                freeSimpleList(simpleList);
+                return 1;
+            }
+            printf("\nSorting both lists first...\n");
+            simpleList = sortSimpleList(simpleList);
+            otherSimple = sortSimpleList(otherSimple);
+            printSimpleList(simpleList);
+            printSimpleList(otherSimple);
+            
+            printf("\n1. Union\n2. Intersection\n3. Difference (first minus second)\n");
+            operation = getIntInput("Enter your choice (1-3): ");
+            if (operation < 1 || operation > 3) {
+                printf("Invalid operation!\n");
+                freeSimpleList(otherSimple);
+            } else {
+                op = (setOperation)(operation - 1);
+                // Reuse the input nodes: both lists are consumed into the result
+                simpleList = setOperationSimple(simpleList, otherSimple, op, 1);
+                printf("Result: ");
+                printSimpleList(simpleList);
+            }
+        } else if (operation == 5) {
+            // Duplicates are adjacent once the list is sorted
+            printf("\nSorting the list first...\n");
+            simpleList = sortSimpleList(simpleList);
+            simpleList = dedupSimple(simpleList, 1);
+            printf("Without duplicates: ");
+            printSimpleList(simpleList);
+        } else if (operation == 6) {
+            // Hot values migrate toward the head as they are searched
+            printf("\n1. Plain\n2. Move to front\n3. Transpose\n");
+            strategy = getIntInput("Enter your choice (1-3): ");
+            if (strategy < 1 || strategy > 3) {
+                printf("Invalid strategy!\n");
+                freeSimpleList(simpleList);
+                return 1;
+            }
+            n = getIntInput("Enter the number of searches: ");
+            for (i = 0; i < n; i++) {
+                value = getIntInput("Enter a value to search: ");
+                if (searchSelfOrganizing(&simpleList, value, (searchStrategy)(strategy - 1), &stats))
+                    printf("%d found in the list.\n", value);
+                else
+                    printf("%d not found in the list.\n", value);
+            }
+            printf("Final list: ");
+            printSimpleList(simpleList);
+            printf("Average probe length: %.2f\n", averageProbeLength(&stats));
+        } else if (operation == 7) {
+            // Delta-encoded blocks of the sorted values
+            printf("\nSorting the list first...\n");
+            simpleList = sortSimpleList(simpleList);
+            compressed = compressedFromSimple(simpleList);
+            if (compressed == NULL) {
+                freeSimpleList(simpleList);
+                return 1;
+            }
+            printCompressedList(compressed);
+            for (n = 0, p = simpleList; p != NULL; p = p->next)
+                n++;
+            printf("Memory: %zu bytes as nodes, %zu bytes compressed\n",
+                   n * sizeof(node), compressedMemoryUsage(compressed));
+            
+            value = getIntInput("\nEnter a value to insert in sorted order: ");
+            compressed = insertSortedCompressed(compressed, value);
+            value = getIntInput("Enter a value to search and delete: ");
+            if (searchCompressed(compressed, value)) {
+                printf("%d found in the list.\n", value);
+                compressed = deleteOccurrenceCompressed(compressed, value);
+                printf("All occurrences of %d deleted.\n", value);
+            } else {
+                printf("%d not found in the list.\n", value);
+            }
+            printf("Final list: ");
+            printCompressedList(compressed);
+            freeCompressedList(compressed);
+        } else if (operation == 8) {
+            // All keys answered by one walk of the list
+            n = getIntInput("\nEnter the number of values to search: ");
+            if (n <= 0) {
+                printf("Invalid number of values!\n");
+                freeSimpleList(simpleList);
+                return 1;
+            }
+            keys = malloc(n * sizeof(*keys));
+            counts = malloc(n * sizeof(*counts));
+            if (keys == NULL || counts == NULL) {
+                printf("Memory allocation failed\n");
+                free(keys);
+                free(counts);
+                freeSimpleList(simpleList);
+                return 1;
+            }
+            for (i = 0; i < n; i++)
+                keys[i] = getIntInput("Enter a value to search: ");
+            if (searchBatchSimple(simpleList, keys, n, counts) >= 0) {
+                for (i = 0; i < n; i++) {
+                    if (counts[i] > 0)
+                        printf("%d found %d time(s) in the list.\n", keys[i], counts[i]);
+                    else
+                        printf("%d not found in the list.\n", keys[i]);
+                }
+            }
+            free(keys);
+            free(counts);
+        } else if (operation == 9) {
+            // Generated lists, independent of the one entered above
+            n = getIntInput("\nEnter the total number of nodes: ");
+            nkeys = getIntInput("Enter the number of keys: ");
+            nlists = getIntInput("Enter the number of lists: ");
+            if (n <= 0 || nkeys <= 0 || nlists <= 0 || nlists > n) {
+                printf("Invalid benchmark size!\n");
+            } else {
+                srand((unsigned int)time(NULL));
+                benchmarkBatchSearch(n, nkeys, nlists);
+            }
         } else {
             printf("Invalid operation!\n");
         }
@@ -702,8 +2045,10 @@ int main() {
     // DOUBLY LINKED LIST OPERATIONS
     } else if (listType == 2) {
         printf("1. Insert an element in sorted order\n");
+        printf("2. Combine with a second list (union, intersection, difference)\n");
+        printf("3. Remove duplicate values\n");
         
-        operation = getIntInput("Enter your choice (1): ");
+        operation = getIntInput("Enter your choice (1-3): ");
         
         if (operation == 1) {
             // Sorted insertion operation
@@ -714,6 +2059,44 @@ int main() {
             doublyList = insertSortedDoubly(doublyList, value);
             printf("After insertion: ");
             printDoublyList(doublyList);
+        } else if (operation == 2) {
+            // Merge-based set operation between two sorted lists
+            n = getIntInput("\nEnter the number of elements in the second list: ");
+            if (n <= 0) {
+                printf("Invalid number of elements!\n");
+                freeDoublyList(doublyList);
+                return 1;
+            }
+            otherDoubly = createDoublyList(n);
+            if (otherDoubly == NULL) {
+                freeDoublyList(doublyList);
+                return 1;
+            }
+            printf("\nSorting both lists first...\n");
+            doublyList = sortDoublyList(doublyList);
+            otherDoubly = sortDoublyList(otherDoubly);
+            printDoublyList(doublyList);
+            printDoublyList(otherDoubly);
+            
+            printf("\n1. Union\n2. Intersection\n3. Difference (first minus second)\n");
+            operation = getIntInput("Enter your choice (1-3): ");
+            if (operation < 1 || operation > 3) {
+                printf("Invalid operation!\n");
+                freeDoublyList(otherDoubly);
+            } else {
+                op = (setOperation)(operation - 1);
+                // Reuse the input nodes: both lists are consumed into the result
+                doublyList = setOperationDoubly(doublyList, otherDoubly, op, 1);
+                printf("Result: ");
+                printDoublyList(doublyList);
+            }
+        } else if (operation == 3) {
+            // Duplicates are adjacent once the list is sorted
+            printf("\nSorting the list first...\n");
+            doublyList = sortDoublyList(doublyList);
+            doublyList = dedupDoubly(doublyList, 1);
+            printf("Without duplicates: ");
+            printDoublyList(doublyList);
         } else {
             printf("Invalid operation!\n");
         }